@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+# Copyright 2025 The Emscripten Authors.  All rights reserved.
+# Emscripten is available under two separate licenses, the MIT license and the
+# University of Illinois/NCSA Open Source License.  Both these licenses can be
+# found in the LICENSE file.
+
+"""A minimal remote tier for the launcher's compile cache, for testing.
+
+Serves GET and PUT of cache entry files under any URL path, storing them
+flat in a directory:
+
+  python tools/cache_server.py --directory remote-cache --port 8080
+  set EM_LAUNCHER_CACHE_REMOTE=http://127.0.0.1:8080/
+
+It listens on loopback only and does no authentication or eviction; use
+bazel-remote or a similar server for anything shared.
+"""
+
+import argparse
+import http.server
+import os
+import re
+import tempfile
+
+# Entry files are named <32 hex digits>.<suffix>, see cache.c.inc.
+NAME_PATTERN = re.compile(r'^[0-9a-f]{32}\.[a-z0-9]+$')
+MAX_OBJECT_SIZE = 1 << 30
+
+
+class CacheHandler(http.server.BaseHTTPRequestHandler):
+  protocol_version = 'HTTP/1.1'
+
+  def object_path(self):
+    name = self.path.split('?')[0].rsplit('/', 1)[-1]
+    if not NAME_PATTERN.match(name):
+      self.send_error(400, 'bad object name')
+      return None
+    return os.path.join(self.server.directory, name)
+
+  def do_GET(self):
+    path = self.object_path()
+    if not path:
+      return
+    try:
+      with open(path, 'rb') as f:
+        data = f.read()
+    except FileNotFoundError:
+      self.send_error(404)
+      return
+    self.send_response(200)
+    self.send_header('Content-Type', 'application/octet-stream')
+    self.send_header('Content-Length', str(len(data)))
+    self.end_headers()
+    self.wfile.write(data)
+
+  def do_PUT(self):
+    path = self.object_path()
+    if not path:
+      return
+    length = int(self.headers.get('Content-Length', -1))
+    if length < 0 or length > MAX_OBJECT_SIZE:
+      self.send_error(411 if length < 0 else 413)
+      return
+    data = self.rfile.read(length)
+    # Readers never see a partially written object.
+    fd, temp_path = tempfile.mkstemp(dir=self.server.directory, suffix='.tmp')
+    with os.fdopen(fd, 'wb') as f:
+      f.write(data)
+    os.replace(temp_path, path)
+    self.send_response(201)
+    self.send_header('Content-Length', '0')
+    self.end_headers()
+
+  def log_message(self, format, *args):
+    if self.server.verbose:
+      super().log_message(format, *args)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('--directory', required=True,
+                      help='where the cache entry files are stored')
+  parser.add_argument('--port', type=int, default=8080)
+  parser.add_argument('--verbose', action='store_true',
+                      help='log every request')
+  args = parser.parse_args()
+  os.makedirs(args.directory, exist_ok=True)
+  server = http.server.ThreadingHTTPServer(('127.0.0.1', args.port),
+                                           CacheHandler)
+  server.directory = os.path.abspath(args.directory)
+  server.verbose = args.verbose
+  print(f'serving {server.directory} on http://127.0.0.1:{args.port}/')
+  try:
+    server.serve_forever()
+  except KeyboardInterrupt:
+    pass
+
+
+if __name__ == '__main__':
+  main()
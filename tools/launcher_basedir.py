@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+# Copyright 2025 The Emscripten Authors.  All rights reserved.
+# Emscripten is available under two separate licenses, the MIT license and the
+# University of Illinois/NCSA Open Source License.  Both these licenses can be
+# found in the LICENSE file.
+
+"""Checks that two checkouts of one project share the compile cache.
+
+With EM_LAUNCHER_CACHE_BASEDIR set to the checkout, paths inside it are
+hashed relative to the working directory, so a second checkout elsewhere
+should hit every entry the first one stored. This writes the same small
+project into two checkouts at paths of different lengths, compiles it in the
+first and then in the second, each with the base directory set to its own
+checkout, and checks with the hit counter of `--launcher-cache-stats` that
+the second build was all hits, and that its dependency files name the second
+checkout:
+
+  python tools/launcher_basedir.py C:\\emsdk\\upstream\\emscripten\\emcc.exe
+  python tools/launcher_basedir.py emcc.exe -v
+
+The compiles pass paths relative and absolute, with -I, -o and -MF, and one
+builds debug info with -ffile-prefix-map, which keeps the working directory
+out of the key.
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+FILES = {
+  os.path.join('include', 'util.h'): 'int util(int value);\n',
+  os.path.join('src', 'util.c'):
+    '#include "util.h"\nint util(int value) { return value * 2; }\n',
+  os.path.join('src', 'main.c'):
+    '#include "util.h"\nint main(void) { return util(0); }\n',
+}
+
+
+def compiles(checkout):
+  """The compile arguments of the build of |checkout|, run in it."""
+  def path(*parts):
+    return os.path.join(checkout, *parts)
+  return [
+    ['-c', os.path.join('src', 'util.c'), '-Iinclude',
+     '-o', os.path.join('build', 'util.o')],
+    ['-c', path('src', 'main.c'), '-I' + path('include'),
+     '-o', path('build', 'main.o'), '-MMD', '-MF', path('build', 'main.d')],
+    ['-c', os.path.join('src', 'main.c'), '-Iinclude', '-g',
+     '-ffile-prefix-map=' + checkout + '=.',
+     '-o', os.path.join('build', 'main-g.o')],
+  ]
+
+
+def cache_counters(emcc, env):
+  output = subprocess.run([emcc, '--launcher-cache-stats'], env=env,
+                          stdout=subprocess.PIPE, universal_newlines=True,
+                          check=True).stdout
+  counters = {}
+  for name in ('hits', 'misses'):
+    match = re.search(r'^%s\s+(\d+)' % name, output, re.MULTILINE)
+    counters[name] = int(match.group(1)) if match else 0
+  return counters
+
+
+def build(emcc, env, checkout, verbose):
+  """Compiles |checkout|; returns whether every compile succeeded."""
+  env = dict(env, EM_LAUNCHER_CACHE_BASEDIR=checkout)
+  os.makedirs(os.path.join(checkout, 'build'))
+  ok = True
+  for arguments in compiles(checkout):
+    command = [emcc] + arguments
+    if verbose:
+      print(' '.join(command))
+    result = subprocess.run(command, cwd=checkout, env=env,
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            universal_newlines=True)
+    if result.returncode:
+      print(result.stdout, end='')
+      ok = False
+  return ok
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('emcc', help='the emcc launcher')
+  parser.add_argument('-v', '--verbose', action='store_true',
+                      help='print the compile commands')
+  args = parser.parse_args()
+
+  work = tempfile.mkdtemp(prefix='launcher-basedir-')
+  try:
+    env = dict(os.environ)
+    env.pop('EM_LAUNCHER_CACHE_REMOTE', None)
+    # Explicitly off, or a calibrated launcher may pick the server.
+    env['EM_LAUNCHER_SERVER'] = '0'
+    env['EM_LAUNCHER_CACHE'] = os.path.join(work, 'cache')
+    checkouts = [os.path.join(work, 'one', 'project'),
+                 os.path.join(work, 'second', 'nested', 'project')]
+    for checkout in checkouts:
+      for name, contents in FILES.items():
+        path = os.path.join(checkout, name)
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        with open(path, 'w') as f:
+          f.write(contents)
+
+    if not build(args.emcc, env, checkouts[0], args.verbose):
+      print('the first build failed')
+      return 1
+    before = cache_counters(args.emcc, env)
+    if not build(args.emcc, env, checkouts[1], args.verbose):
+      print('the second build failed')
+      return 1
+    after = cache_counters(args.emcc, env)
+    count = len(compiles(checkouts[1]))
+    hits = after['hits'] - before['hits']
+    misses = after['misses'] - before['misses']
+    with open(os.path.join(checkouts[1], 'build', 'main.d')) as f:
+      dependencies = f.read()
+    # Dependency files may name paths with either separator.
+    names_first = (checkouts[0] in dependencies or
+                   checkouts[0].replace('\\', '/') in dependencies)
+    print(f'second checkout: {hits} hits, {misses} misses of {count} '
+          f'compiles')
+    if names_first:
+      print('main.d names the first checkout')
+    failed = hits != count or misses or names_first
+    print('FAILED' if failed else 'ok')
+    return 1 if failed else 0
+  finally:
+    shutil.rmtree(work, ignore_errors=True)
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+# Copyright 2025 The Emscripten Authors.  All rights reserved.
+# Emscripten is available under two separate licenses, the MIT license and the
+# University of Illinois/NCSA Open Source License.  Both these licenses can be
+# found in the LICENSE file.
+
+"""Checks that a storm of launchers starts exactly one compile server.
+
+When a build starts, hundreds of launchers find no server at once. One of
+them must start it while the others wait, and every launch must then be
+served. This copies the launcher next to a stub script into a new directory,
+which gives it a server name of its own, starts a few hundred launchers of
+the stub suspended and releases them together, and checks that each
+succeeded on the server and that exactly one of them started a server:
+
+  python tools/launcher_cold_start.py C:\\emsdk\\upstream\\emscripten\\emcc.exe
+  python tools/launcher_cold_start.py emcc.exe --launches 500
+
+Each launcher runs in a job object of its own that it cannot leave, so the
+server it starts, if any, is counted in that job. The stub prints the id of
+the process that runs it, which differs from the launcher's on the server.
+The server is ended at the end.
+"""
+
+import argparse
+import ctypes
+import ctypes.wintypes
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+STUB_NAME = 'launcher_cold_start_stub'
+STUB_SCRIPT = 'import os\nprint(os.getpid())\n'
+
+CREATE_SUSPENDED = 0x4
+JOB_OBJECT_BASIC_ACCOUNTING_INFORMATION = 1
+
+
+class JobAccounting(ctypes.Structure):
+  """JOBOBJECT_BASIC_ACCOUNTING_INFORMATION"""
+  _fields_ = [
+    ('TotalUserTime', ctypes.c_int64),
+    ('TotalKernelTime', ctypes.c_int64),
+    ('ThisPeriodTotalUserTime', ctypes.c_int64),
+    ('ThisPeriodTotalKernelTime', ctypes.c_int64),
+    ('TotalPageFaultCount', ctypes.wintypes.DWORD),
+    ('TotalProcesses', ctypes.wintypes.DWORD),
+    ('ActiveProcesses', ctypes.wintypes.DWORD),
+    ('TotalTerminatedProcesses', ctypes.wintypes.DWORD),
+  ]
+
+
+def windows_api():
+  kernel32 = ctypes.WinDLL('kernel32', use_last_error=True)
+  ntdll = ctypes.WinDLL('ntdll')
+  handle = ctypes.wintypes.HANDLE
+  kernel32.CreateJobObjectW.restype = handle
+  kernel32.CreateJobObjectW.argtypes = [ctypes.c_void_p, ctypes.c_wchar_p]
+  kernel32.AssignProcessToJobObject.argtypes = [handle, handle]
+  kernel32.QueryInformationJobObject.argtypes = [
+    handle, ctypes.c_int, ctypes.c_void_p, ctypes.wintypes.DWORD,
+    ctypes.c_void_p]
+  kernel32.TerminateJobObject.argtypes = [handle, ctypes.wintypes.UINT]
+  kernel32.CloseHandle.argtypes = [handle]
+  ntdll.NtResumeProcess.argtypes = [handle]
+  return kernel32, ntdll
+
+
+def job_processes(kernel32, job):
+  """The number of processes ever started in |job|."""
+  info = JobAccounting()
+  if not kernel32.QueryInformationJobObject(
+      job, JOB_OBJECT_BASIC_ACCOUNTING_INFORMATION, ctypes.byref(info),
+      ctypes.sizeof(info), None):
+    raise ctypes.WinError(ctypes.get_last_error())
+  return info.TotalProcesses
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('launcher', help='the launcher to check')
+  parser.add_argument('--launches', type=int, default=300,
+                      help='launchers to start at once')
+  args = parser.parse_args()
+  if sys.platform != 'win32':
+    print('the compile server is Windows only')
+    return 1
+  kernel32, ntdll = windows_api()
+
+  directory = tempfile.mkdtemp(prefix='launcher-cold-start-')
+  launches = []
+  try:
+    with open(os.path.join(directory, STUB_NAME + '.py'), 'w') as f:
+      f.write(STUB_SCRIPT)
+    command = [os.path.join(directory, STUB_NAME + '.exe')]
+    shutil.copy2(args.launcher, command[0])
+    env = dict(os.environ)
+    for name in ('EM_LAUNCHER_CACHE', 'EM_LAUNCHER_TELEMETRY',
+                 'EM_LAUNCHER_PROFILE', 'EM_LAUNCHER_RECORD'):
+      env.pop(name, None)
+    env['EM_LAUNCHER_SERVER'] = '1'
+
+    for _ in range(args.launches):
+      job = kernel32.CreateJobObjectW(None, None)
+      if not job:
+        raise ctypes.WinError(ctypes.get_last_error())
+      process = subprocess.Popen(command, env=env, stdin=subprocess.DEVNULL,
+                                 stdout=subprocess.PIPE,
+                                 stderr=subprocess.DEVNULL,
+                                 creationflags=CREATE_SUSPENDED,
+                                 universal_newlines=True)
+      launches.append((process, job))
+      if not kernel32.AssignProcessToJobObject(job, int(process._handle)):
+        raise ctypes.WinError(ctypes.get_last_error())
+    for process, _ in launches:
+      ntdll.NtResumeProcess(int(process._handle))
+
+    failed = 0
+    in_process = 0
+    for process, _ in launches:
+      output = process.communicate()[0].strip()
+      if process.returncode:
+        failed += 1
+      elif output == str(process.pid):
+        in_process += 1
+    servers = sum(job_processes(kernel32, job) > 1 for _, job in launches)
+    print(f'{args.launches} launches: {failed} failed, {in_process} ran in '
+          f'process, {servers} started a server')
+    bad = failed or in_process or servers != 1
+    print('FAILED' if bad else 'ok')
+    return 1 if bad else 0
+  finally:
+    for process, job in launches:
+      if process.poll() is None:
+        process.kill()
+      # Ends the server and its workers in the job of the launcher that
+      # started it.
+      kernel32.TerminateJobObject(job, 1)
+      kernel32.CloseHandle(job)
+    shutil.rmtree(directory, ignore_errors=True)
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+# Copyright 2025 The Emscripten Authors.  All rights reserved.
+# Emscripten is available under two separate licenses, the MIT license and the
+# University of Illinois/NCSA Open Source License.  Both these licenses can be
+# found in the LICENSE file.
+
+"""Shows and ranks the imports recorded by launcher server workers.
+
+With EM_LAUNCHER_SERVER_IMPORTS set to a directory, every job run by the
+launcher's resident server leaves a record there of the modules its script
+imported (see server.c.inc). This prints how often each module was used and
+how long loading it took, and with --write-preload writes the modules that
+most jobs of some class use to preload.txt, which new workers import before
+they take a job:
+
+  set EM_LAUNCHER_SERVER=1
+  set EM_LAUNCHER_SERVER_IMPORTS=C:\\build\\imports
+  ninja
+  python tools/launcher_imports.py C:\\build\\imports --write-preload
+
+Load times include the modules a module imports itself. Modules from the
+emscripten directory are never preloaded, since they read the job's
+configuration and environment when imported.
+"""
+
+import argparse
+import collections
+import glob
+import json
+import os
+
+PRELOAD_FILE = 'preload.txt'
+
+
+def load_records(directory):
+  records = []
+  for path in glob.glob(os.path.join(directory, '*.json')):
+    try:
+      with open(path) as f:
+        records.append(json.load(f))
+    except (OSError, ValueError):
+      pass
+  return records
+
+
+class ModuleStats:
+  def __init__(self):
+    self.jobs_by_class = collections.Counter()
+    self.load_times = []
+    self.preload_times = []
+    self.local = False
+
+
+def collect(records):
+  jobs_by_class = collections.Counter(r['class'] for r in records)
+  modules = collections.defaultdict(ModuleStats)
+  for record in records:
+    local = set(record.get('local', ()))
+    for name, elapsed in record['imported'].items():
+      stats = modules[name]
+      stats.jobs_by_class[record['class']] += 1
+      stats.local |= name in local
+      if elapsed is not None:
+        stats.load_times.append(elapsed)
+    for name, elapsed in record.get('preloaded', {}).items():
+      modules[name].preload_times.append(elapsed)
+  return jobs_by_class, modules
+
+
+def usage(stats, jobs_by_class):
+  """The largest share of the jobs of one class that used the module."""
+  return max((count / jobs_by_class[kind]
+              for kind, count in stats.jobs_by_class.items()), default=0)
+
+
+def mean_ms(times):
+  return 1000 * sum(times) / len(times) if times else 0
+
+
+def print_report(jobs_by_class, modules, top):
+  print('jobs: ' + ', '.join(f'{count} {kind}'
+                             for kind, count in jobs_by_class.most_common()))
+  print()
+  print(f'{"module":40} {"usage":>6} {"loaded":>7} {"load ms":>8} '
+        f'{"total ms":>9} {"preload ms":>10}')
+  # Most time spent loading first: those are the ones preloading saves.
+  ranked = sorted(modules.items(),
+                  key=lambda item: -sum(item[1].load_times))
+  for name, stats in ranked[:top]:
+    label = name + (' (local)' if stats.local else '')
+    print(f'{label:40} {usage(stats, jobs_by_class):6.0%} '
+          f'{len(stats.load_times):7} {mean_ms(stats.load_times):8.1f} '
+          f'{1000 * sum(stats.load_times):9.0f} '
+          f'{mean_ms(stats.preload_times):10.1f}')
+
+
+def write_preload(directory, jobs_by_class, modules, threshold):
+  chosen = [(usage(stats, jobs_by_class), name)
+            for name, stats in modules.items()
+            if not stats.local and usage(stats, jobs_by_class) >= threshold]
+  chosen.sort(key=lambda item: (-item[0], item[1]))
+  path = os.path.join(directory, PRELOAD_FILE)
+  # Workers may be reading the old list; replace it in one step.
+  with open(path + '.tmp', 'w') as f:
+    for _, name in chosen:
+      f.write(name + '\n')
+  os.replace(path + '.tmp', path)
+  print(f'wrote {len(chosen)} modules to {path}')
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('directory',
+                      help='the EM_LAUNCHER_SERVER_IMPORTS directory')
+  parser.add_argument('--top', type=int, default=40,
+                      help='number of modules to show')
+  parser.add_argument('--write-preload', action='store_true',
+                      help=f'write the ranked list to {PRELOAD_FILE}')
+  parser.add_argument('--threshold', type=float, default=0.5,
+                      help='share of the jobs of some class that must use a '
+                           'module for it to be preloaded')
+  parser.add_argument('--clear', action='store_true',
+                      help='delete the records once they are processed')
+  args = parser.parse_args()
+  records = load_records(args.directory)
+  if not records:
+    parser.error(f'no import records in {args.directory}')
+  jobs_by_class, modules = collect(records)
+  print_report(jobs_by_class, modules, args.top)
+  if args.write_preload:
+    write_preload(args.directory, jobs_by_class, modules, args.threshold)
+  if args.clear:
+    for path in glob.glob(os.path.join(args.directory, '*.json')):
+      os.remove(path)
+
+
+if __name__ == '__main__':
+  main()
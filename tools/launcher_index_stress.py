@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+# Copyright 2025 The Emscripten Authors.  All rights reserved.
+# Emscripten is available under two separate licenses, the MIT license and the
+# University of Illinois/NCSA Open Source License.  Both these licenses can be
+# found in the LICENSE file.
+
+"""Stresses one compile cache index from many processes at once.
+
+The cache index is a shared_table in a file that every launcher maps, so its
+inserts, lookups and removes race across processes, not only across the
+threads `--launcher-cache-index-benchmark` runs. This starts several
+processes of that benchmark at once on one shared index file, each with a few
+writer threads, then has a last one count what they left behind:
+
+  python tools/launcher_index_stress.py C:\\emsdk\\upstream\\emscripten\\emcc.exe
+  python tools/launcher_index_stress.py emcc.exe --processes 32 --writers 4
+
+Every writer removes each of its keys but the last 4 it inserted, and no two
+writers share a key, so the index must end with exactly 4 live entries per
+writer: more means an entry was stored twice or not removed, fewer that one
+was lost. It must also end with no busy slots, and no insert may have found
+the index full.
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# The keys each writer leaves live.
+KEPT_PER_WRITER = 4
+
+
+def benchmark(launcher, writers, operations, index):
+  return subprocess.Popen([launcher, '--launcher-cache-index-benchmark',
+                           str(writers), str(operations), index],
+                          stdin=subprocess.DEVNULL, stdout=subprocess.PIPE,
+                          stderr=subprocess.STDOUT, universal_newlines=True)
+
+
+def number(pattern, output):
+  match = re.search(pattern, output)
+  return int(match.group(1)) if match else None
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('launcher', help='the launcher to run the benchmark')
+  parser.add_argument('--processes', type=int, default=16,
+                      help='benchmark processes to run at once')
+  parser.add_argument('--writers', type=int, default=2,
+                      help='writer threads in each process')
+  parser.add_argument('--operations', type=int, default=20000,
+                      help='operations of each writer')
+  parser.add_argument('-v', '--verbose', action='store_true',
+                      help='print the output of every process')
+  args = parser.parse_args()
+
+  work = tempfile.mkdtemp(prefix='launcher-index-stress-')
+  try:
+    index = os.path.join(work, 'index')
+    processes = [benchmark(args.launcher, args.writers, args.operations,
+                           index) for _ in range(args.processes)]
+    failures = 0
+    full = 0
+    for process in processes:
+      output = process.communicate()[0]
+      if args.verbose:
+        print(output, end='')
+      failures += process.returncode != 0
+      full += number(r'(\d+) inserts found no slot', output) or 0
+
+    # A benchmark without operations only counts.
+    output = subprocess.run([args.launcher, '--launcher-cache-index-benchmark',
+                             '1', '0', index], stdout=subprocess.PIPE,
+                            universal_newlines=True).stdout
+    live = number(r'(\d+) live entries', output)
+    busy = number(r'(\d+) busy slots', output)
+    expected = (args.processes * args.writers *
+                min(args.operations, KEPT_PER_WRITER))
+    print(f'{args.processes} processes of {args.writers} writers, '
+          f'{args.operations} operations each')
+    print(f'{live} live entries of {expected} expected, {busy} busy slots, '
+          f'{full} inserts found no slot, {failures} processes failed')
+    failed = failures or full or live != expected or busy != 0
+    print('FAILED' if failed else 'ok')
+    return 1 if failed else 0
+  finally:
+    shutil.rmtree(work, ignore_errors=True)
+
+
+if __name__ == '__main__':
+  sys.exit(main())
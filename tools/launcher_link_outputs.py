@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+# Copyright 2025 The Emscripten Authors.  All rights reserved.
+# Emscripten is available under two separate licenses, the MIT license and the
+# University of Illinois/NCSA Open Source License.  Both these licenses can be
+# found in the LICENSE file.
+
+"""Checks that cached links restore every file the link writes.
+
+A link may write several files next to its target, and which ones depends on
+its settings: the .wasm, source and symbol maps, pthread and audio worklet
+scripts, split modules, ... This links a small program with each of a set of
+settings twice through the compile cache, emptying the output directory in
+between, and checks that the second link, a hit when the cache stored the
+first, leaves exactly the same files with the same contents as the first:
+
+  python tools/launcher_link_outputs.py C:\\emsdk\\upstream\\emscripten\\emcc.exe
+  python tools/launcher_link_outputs.py emcc.exe --config audio-worklet -v
+
+A link whose files a hit could not restore must not be stored at all, so it
+shows up here as a relink, which is fine, rather than as missing files.
+"""
+
+import argparse
+import hashlib
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SOURCE = 'int main(void) { return 0; }\n'
+
+# Link arguments that need the object built with atomics.
+THREAD_ARGUMENTS = ('-pthread', '-sWASM_WORKERS')
+
+# Name, target and extra link arguments.
+CONFIGS = [
+  ('plain', 'app.js', []),
+  ('html', 'app.html', []),
+  ('wasm', 'app.wasm', ['--no-entry']),
+  ('symbol-map', 'app.js', ['--emit-symbol-map']),
+  ('source-map', 'app.js', ['-gsource-map']),
+  ('pthreads', 'app.js', ['-pthread']),
+  ('wasm-workers', 'app.js', ['-sWASM_WORKERS']),
+  ('audio-worklet', 'app.js', ['-sAUDIO_WORKLET', '-sWASM_WORKERS']),
+  ('split-module', 'app.js', ['-sSPLIT_MODULE']),
+]
+
+
+def snapshot(directory):
+  """The files in |directory| and the hashes of their contents."""
+  files = {}
+  for name in sorted(os.listdir(directory)):
+    with open(os.path.join(directory, name), 'rb') as f:
+      files[name] = hashlib.sha256(f.read()).hexdigest()
+  return files
+
+
+def link_hits(emcc, env):
+  output = subprocess.run([emcc, '--launcher-cache-stats'], env=env,
+                          stdout=subprocess.PIPE, universal_newlines=True,
+                          check=True).stdout
+  match = re.search(r'^link hits\s+(\d+)', output, re.MULTILINE)
+  return int(match.group(1)) if match else 0
+
+
+def link(emcc, env, obj, directory, target, arguments, verbose):
+  command = [emcc, obj, '-o', os.path.join(directory, target)] + arguments
+  if verbose:
+    print(' '.join(command))
+  result = subprocess.run(command, env=env, stdout=subprocess.PIPE,
+                          stderr=subprocess.STDOUT, universal_newlines=True)
+  if result.returncode:
+    print(result.stdout, end='')
+  return result.returncode == 0
+
+
+def check(emcc, env, obj, work, config, verbose):
+  """Links with |config| twice; returns (outcome, differences)."""
+  name, target, arguments = config
+  directory = os.path.join(work, name)
+  os.makedirs(directory)
+  if not link(emcc, env, obj, directory, target, arguments, verbose):
+    return 'link failed', []
+  first = snapshot(directory)
+  shutil.rmtree(directory)
+  os.makedirs(directory)
+  hits = link_hits(emcc, env)
+  if not link(emcc, env, obj, directory, target, arguments, verbose):
+    return 'relink failed', []
+  outcome = 'hit' if link_hits(emcc, env) > hits else 'relinked'
+  second = snapshot(directory)
+  differences = []
+  for file in sorted(set(first) | set(second)):
+    if file not in second:
+      differences.append(f'{file} missing')
+    elif file not in first:
+      differences.append(f'{file} extra')
+    elif first[file] != second[file]:
+      differences.append(f'{file} differs')
+  return outcome, differences
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('emcc', help='the emcc launcher')
+  parser.add_argument('--config', action='append',
+                      choices=[config[0] for config in CONFIGS],
+                      help='settings to check (all by default)')
+  parser.add_argument('--cache-directory',
+                      help='compile cache to use (a new one by default)')
+  parser.add_argument('-v', '--verbose', action='store_true',
+                      help='print the link commands')
+  args = parser.parse_args()
+  configs = [c for c in CONFIGS if not args.config or c[0] in args.config]
+
+  work = tempfile.mkdtemp(prefix='launcher-link-outputs-')
+  try:
+    env = dict(os.environ)
+    env.pop('EM_LAUNCHER_CACHE_REMOTE', None)
+    # Explicitly off, or a calibrated launcher may pick the server.
+    env['EM_LAUNCHER_SERVER'] = '0'
+    env['EM_LAUNCHER_CACHE'] = (args.cache_directory or
+                                os.path.join(work, 'cache'))
+    source = os.path.join(work, 'main.c')
+    with open(source, 'w') as f:
+      f.write(SOURCE)
+    # Threads and wasm workers need atomics in every object, which the
+    # other links reject.
+    objects = {}
+    for threads in (False, True):
+      objects[threads] = os.path.join(work, f'main{"-mt" if threads else ""}.o')
+      subprocess.run([args.emcc, '-c', source, '-o', objects[threads]] +
+                     (['-pthread'] if threads else []), env=env, check=True)
+    failures = 0
+    for config in configs:
+      threads = any(a in THREAD_ARGUMENTS for a in config[2])
+      outcome, differences = check(args.emcc, env, objects[threads], work,
+                                   config, args.verbose)
+      failed = differences or outcome.endswith('failed')
+      failures += bool(failed)
+      print(f'{config[0]:14} {outcome:14} ' +
+            ('; '.join(differences) if differences else
+             'FAILED' if failed else 'ok'))
+  finally:
+    shutil.rmtree(work, ignore_errors=True)
+  return 1 if failures else 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
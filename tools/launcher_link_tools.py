@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+# Copyright 2025 The Emscripten Authors.  All rights reserved.
+# Emscripten is available under two separate licenses, the MIT license and the
+# University of Illinois/NCSA Open Source License.  Both these licenses can be
+# found in the LICENSE file.
+
+"""Checks that the tools linked by `--launcher-link-tools` run their scripts.
+
+After `--launcher-link-tools` every tool in the launcher's directory is a hard
+link to one launcher file, and only the name a link is started under picks
+its script. This copies the launcher under a few tool names into a new
+directory, each next to a stub script that prints its own name, adds the
+script of one more tool without a copy, and runs `--launcher-link-tools` with
+that tool's name. It then runs every tool and checks that each ran its own
+script with its arguments, and that all of them are one file:
+
+  python tools/launcher_link_tools.py C:\\emsdk\\upstream\\emscripten\\emcc.exe
+  python tools/launcher_link_tools.py emcc.exe -v
+
+An executable next to them that is not a copy of the launcher must be left
+alone.
+"""
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# Copied from the launcher before linking.
+COPIED_TOOLS = ['emcc', 'em++', 'emar', 'emcmake']
+# Only has a script, and is named on the command line.
+NEW_TOOL = 'emnew'
+# Not a copy of the launcher.
+OTHER_EXECUTABLE = 'other.exe'
+
+STUB_SCRIPT = '''\
+import os, sys
+print(' '.join([os.path.basename(__file__)] + sys.argv[1:]))
+'''
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('launcher', help='the launcher to link the tools to')
+  parser.add_argument('-v', '--verbose', action='store_true',
+                      help='print the output of --launcher-link-tools')
+  args = parser.parse_args()
+
+  directory = tempfile.mkdtemp(prefix='launcher-link-tools-')
+  try:
+    tools = COPIED_TOOLS + [NEW_TOOL]
+    for tool in tools:
+      with open(os.path.join(directory, tool + '.py'), 'w') as f:
+        f.write(STUB_SCRIPT)
+    for tool in COPIED_TOOLS:
+      shutil.copy2(args.launcher, os.path.join(directory, tool + '.exe'))
+    other = os.path.join(directory, OTHER_EXECUTABLE)
+    with open(other, 'wb') as f:
+      f.write(b'MZ not a launcher')
+    env = dict(os.environ)
+    for name in ('EM_LAUNCHER_CACHE', 'EM_LAUNCHER_TELEMETRY',
+                 'EM_LAUNCHER_PROFILE', 'EM_LAUNCHER_RECORD'):
+      env.pop(name, None)
+    # Explicitly off, or a calibrated launcher may pick the server.
+    env['EM_LAUNCHER_SERVER'] = '0'
+    # Or emar would run llvm-ar rather than its script.
+    env['EM_LAUNCHER_NATIVE_TOOLS'] = '0'
+
+    launcher = os.path.join(directory, COPIED_TOOLS[0] + '.exe')
+    result = subprocess.run([launcher, '--launcher-link-tools', NEW_TOOL],
+                            env=env, stdout=subprocess.PIPE,
+                            stderr=subprocess.STDOUT, universal_newlines=True)
+    if args.verbose or result.returncode:
+      print(result.stdout, end='')
+    if result.returncode:
+      print('--launcher-link-tools failed')
+      print('FAILED')
+      return 1
+
+    failed = False
+    for tool in tools:
+      path = os.path.join(directory, tool + '.exe')
+      if not os.path.isfile(path) or not os.path.samefile(path, launcher):
+        print(f'{tool}: not linked to {COPIED_TOOLS[0]}')
+        failed = True
+        continue
+      output = subprocess.run([path, 'one', 'two'], env=env,
+                              stdin=subprocess.DEVNULL, stdout=subprocess.PIPE,
+                              universal_newlines=True).stdout.strip()
+      expected = tool + '.py one two'
+      if output != expected:
+        print(f'{tool}: ran {output!r}, expected {expected!r}')
+        failed = True
+    links = os.stat(launcher).st_nlink
+    print(f'{len(tools)} tools, {links} links to the launcher')
+    failed = failed or links != len(tools)
+    if os.path.samefile(other, launcher):
+      print(f'{OTHER_EXECUTABLE}: linked, but is not a copy of the launcher')
+      failed = True
+    print('FAILED' if failed else 'ok')
+    return 1 if failed else 0
+  finally:
+    shutil.rmtree(directory, ignore_errors=True)
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+# Copyright 2025 The Emscripten Authors.  All rights reserved.
+# Emscripten is available under two separate licenses, the MIT license and the
+# University of Illinois/NCSA Open Source License.  Both these licenses can be
+# found in the LICENSE file.
+
+"""Merges the profiles written by the launcher across a build.
+
+With EM_LAUNCHER_PROFILE set to a directory, every script the launcher runs
+leaves a profile there (see profile.c.inc). This merges the folded stacks of
+the sampling profiler into one file for a flamegraph, and prints the frames
+most samples were in:
+
+  set EM_LAUNCHER_PROFILE=C:\\build\\profiles
+  ninja
+  python tools/launcher_profile.py C:\\build\\profiles -o build.folded
+  flamegraph.pl build.folded > build.svg
+
+Profiles of EM_LAUNCHER_PROFILE_MODE=cprofile are merged into one .prof file
+instead, given with --prof, and the functions with the most cumulative time
+are printed.
+"""
+
+import argparse
+import collections
+import glob
+import os
+import pstats
+
+
+def merge_folded(paths):
+  stacks = collections.Counter()
+  for path in paths:
+    with open(path) as f:
+      for line in f:
+        stack, _, count = line.rstrip('\n').rpartition(' ')
+        if stack and count.isdigit():
+          stacks[stack] += int(count)
+  return stacks
+
+
+def print_folded_report(stacks, top):
+  total = sum(stacks.values())
+  own = collections.Counter()
+  inclusive = collections.Counter()
+  for stack, count in stacks.items():
+    frames = stack.split(';')
+    own[frames[-1]] += count
+    # Recursion counts a frame once per sample.
+    for frame in set(frames):
+      inclusive[frame] += count
+  print(f'{total} samples')
+  for title, counter in (('own', own), ('inclusive', inclusive)):
+    print()
+    print(f'{title:>9}  frame')
+    for frame, count in counter.most_common(top):
+      print(f'{count / total:9.1%}  {frame}')
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('directory', help='the EM_LAUNCHER_PROFILE directory')
+  parser.add_argument('-o', '--output',
+                      help='write the merged folded stacks here')
+  parser.add_argument('--prof', metavar='FILE',
+                      help='merge the cProfile files into FILE')
+  parser.add_argument('--top', type=int, default=25,
+                      help='number of frames to show')
+  parser.add_argument('--clear', action='store_true',
+                      help='delete the profiles once they are merged')
+  args = parser.parse_args()
+  folded = glob.glob(os.path.join(args.directory, '*.folded'))
+  profiles = glob.glob(os.path.join(args.directory, '*.prof'))
+  if not folded and not profiles:
+    parser.error(f'no profiles in {args.directory}')
+  if folded:
+    stacks = merge_folded(folded)
+    print(f'{len(folded)} sampled invocations')
+    print_folded_report(stacks, args.top)
+    if args.output:
+      with open(args.output, 'w') as f:
+        for stack, count in sorted(stacks.items()):
+          f.write(f'{stack} {count}\n')
+  if profiles:
+    stats = pstats.Stats(*profiles)
+    print()
+    print(f'{len(profiles)} cProfile invocations')
+    stats.sort_stats('cumulative').print_stats(args.top)
+    if args.prof:
+      stats.dump_stats(args.prof)
+  if args.clear:
+    for path in folded + profiles:
+      os.remove(path)
+
+
+if __name__ == '__main__':
+  main()
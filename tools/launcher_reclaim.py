@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+# Copyright 2025 The Emscripten Authors.  All rights reserved.
+# Emscripten is available under two separate licenses, the MIT license and the
+# University of Illinois/NCSA Open Source License.  Both these licenses can be
+# found in the LICENSE file.
+
+"""Checks that the compile server reclaims the jobs of launchers that die.
+
+An interrupted build kills its launchers while their requests run on the
+resident compile server. The server must then end each request's worker and
+every process the worker started, and get back to a full pool of idle
+workers. This starts launchers on the server with a stub script that starts a
+long running child and then sleeps, as a compile running clang would, kills
+them once their requests run, and polls `--launcher-status` until the server
+has no running requests and all its workers are idle again, or a deadline
+passes:
+
+  python tools/launcher_reclaim.py C:\\emsdk\\upstream\\emscripten\\emcc.exe
+  python tools/launcher_reclaim.py emcc.exe --launches 16 --deadline 30
+
+The launcher is copied next to the stub script, whose name it runs. The check
+fails when the deadline passes, when fewer requests than were killed are
+counted as cancelled, or when a child of a killed request outlives it.
+"""
+
+import argparse
+import ctypes
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+STUB_NAME = 'launcher_reclaim_stub'
+
+# Starts a child that outlives the script unless its job is ended, records
+# its process id, and sleeps.
+STUB_SCRIPT = '''\
+import os, subprocess, sys, time
+child = subprocess.Popen(
+  ['ping', '-n', '600', '127.0.0.1'] if sys.platform == 'win32'
+  else ['sleep', '600'], stdout=subprocess.DEVNULL)
+with open(os.path.join(os.environ['LAUNCHER_RECLAIM_PIDS'],
+                       '%d.pid' % os.getpid()), 'w') as f:
+  f.write(str(child.pid))
+time.sleep(600)
+'''
+
+
+def server_metrics(command, env):
+  """The server's metrics without labels, by name, or None."""
+  result = subprocess.run(command + ['--launcher-status'], env=env,
+                          stdin=subprocess.DEVNULL, stdout=subprocess.PIPE,
+                          stderr=subprocess.DEVNULL, universal_newlines=True)
+  if result.returncode:
+    return None
+  return {name: int(value) for name, value in
+          re.findall(r'^emscripten_launcher_server_(\w+) (\d+)$',
+                     result.stdout, re.MULTILINE)}
+
+
+def process_running(pid):
+  if sys.platform != 'win32':
+    try:
+      os.kill(pid, 0)
+    except ProcessLookupError:
+      return False
+    except PermissionError:
+      pass
+    return True
+  kernel32 = ctypes.windll.kernel32
+  # PROCESS_QUERY_LIMITED_INFORMATION
+  handle = kernel32.OpenProcess(0x1000, False, pid)
+  if not handle:
+    return False
+  exit_code = ctypes.c_ulong()
+  ok = kernel32.GetExitCodeProcess(handle, ctypes.byref(exit_code))
+  kernel32.CloseHandle(handle)
+  # STILL_ACTIVE
+  return bool(ok) and exit_code.value == 259
+
+
+def wait_for(condition, deadline):
+  """Polls |condition| until it holds or |deadline| passes."""
+  while True:
+    value = condition()
+    if value or time.monotonic() >= deadline:
+      return value
+    time.sleep(0.25)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('launcher', help='the launcher to check')
+  parser.add_argument('--launches', type=int, default=4,
+                      help='launchers to kill')
+  parser.add_argument('--deadline', type=float, default=20,
+                      help='seconds the server may take to reclaim them')
+  args = parser.parse_args()
+
+  directory = tempfile.mkdtemp(prefix='launcher-reclaim-')
+  launchers = []
+  try:
+    with open(os.path.join(directory, STUB_NAME + '.py'), 'w') as f:
+      f.write(STUB_SCRIPT)
+    extension = os.path.splitext(args.launcher)[1]
+    command = [os.path.join(directory, STUB_NAME + extension)]
+    shutil.copy2(args.launcher, command[0])
+    pids = os.path.join(directory, 'pids')
+    os.makedirs(pids)
+    env = dict(os.environ)
+    for name in ('EM_LAUNCHER_CACHE', 'EM_LAUNCHER_TELEMETRY',
+                 'EM_LAUNCHER_PROFILE', 'EM_LAUNCHER_RECORD'):
+      env.pop(name, None)
+    env['EM_LAUNCHER_SERVER'] = '1'
+    # Enough job slots that every request runs rather than queues.
+    env['EM_LAUNCHER_SERVER_JOBS'] = str(args.launches)
+    env['LAUNCHER_RECLAIM_PIDS'] = pids
+
+    # The first launch starts the server.
+    for _ in range(args.launches):
+      launchers.append(subprocess.Popen(command, env=env,
+                                        stdin=subprocess.DEVNULL,
+                                        stdout=subprocess.DEVNULL,
+                                        stderr=subprocess.DEVNULL))
+    deadline = time.monotonic() + args.deadline
+    started = wait_for(lambda: len(os.listdir(pids)) >= args.launches,
+                       deadline)
+    before = server_metrics(command, env)
+    if not started or not before:
+      print('the requests did not start on the server')
+      return 1
+    children = []
+    for name in os.listdir(pids):
+      with open(os.path.join(pids, name)) as f:
+        children.append(int(f.read()))
+
+    start = time.monotonic()
+    for launcher in launchers:
+      launcher.kill()
+      launcher.wait()
+    deadline = start + args.deadline
+
+    def reclaimed():
+      metrics = server_metrics(command, env)
+      if (metrics and metrics.get('running_requests') == 0 and
+          metrics.get('idle_workers') == metrics.get('pool_size')):
+        return metrics
+      return None
+
+    after = wait_for(reclaimed, deadline)
+    elapsed = time.monotonic() - start
+    orphans = [pid for pid in children if process_running(pid)]
+    cancelled = (after or server_metrics(command, env) or {}).get(
+      'cancelled_total', 0) - before.get('cancelled_total', 0)
+    print(f'killed {args.launches} launchers with running requests')
+    print(f'cancelled {cancelled}, orphaned children {len(orphans)}')
+    if after:
+      print(f'reclaimed in {elapsed:.1f} s: {after["idle_workers"]} idle '
+            f'workers of {after["pool_size"]}')
+    else:
+      print(f'not reclaimed after {args.deadline:g} s')
+    failed = not after or cancelled < args.launches or orphans
+    print('FAILED' if failed else 'ok')
+    return 1 if failed else 0
+  finally:
+    for launcher in launchers:
+      if launcher.poll() is None:
+        launcher.kill()
+    shutil.rmtree(directory, ignore_errors=True)
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+# Copyright 2025 The Emscripten Authors.  All rights reserved.
+# Emscripten is available under two separate licenses, the MIT license and the
+# University of Illinois/NCSA Open Source License.  Both these licenses can be
+# found in the LICENSE file.
+
+"""Replays recorded launcher invocations and measures them.
+
+With EM_LAUNCHER_RECORD set to a directory, every launcher leaves a record of
+its invocation there (see record.c.inc). This runs the recorded invocations
+again, in the order they were recorded and with the given parallelism, in
+their working directory and with their EM* environment, and reports the
+throughput and latency distribution:
+
+  set EM_LAUNCHER_RECORD=C:\\corpus
+  ninja -C C:\\build
+  set EM_LAUNCHER_RECORD=
+  python tools/launcher_replay.py C:\\corpus -j 16 --mode server
+
+The launcher run for a record is the executable next to its script, or the
+one of the same name in --bin. Replays write the outputs of the recorded
+build again, so run them in a tree built from the same sources; records whose
+inputs changed since are reported, and with --check-inputs skipped.
+"""
+
+import argparse
+import concurrent.futures
+import glob
+import hashlib
+import json
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+MODES = ['recorded', 'python', 'cache', 'server']
+LAUNCHER_VARIABLES = ['EM_LAUNCHER_CACHE', 'EM_LAUNCHER_SERVER']
+
+
+def load_corpus(directory):
+  records = []
+  for path in glob.glob(os.path.join(directory, '*.json')):
+    try:
+      with open(path, encoding='utf-8') as f:
+        record = json.load(f)
+    except (OSError, ValueError):
+      continue
+    # Files are named <pid>-<time>.json.
+    name = os.path.splitext(os.path.basename(path))[0]
+    record['order'] = int(name.rpartition('-')[2] or 0)
+    records.append(record)
+  records.sort(key=lambda r: r['order'])
+  return records
+
+
+def file_key(path):
+  """The key the compile cache takes of a file, see hash.c.inc."""
+  with open(path, 'rb') as f:
+    data = f.read()
+  return hashlib.sha256(struct.pack('<Q', len(data)) + data).hexdigest()[:32]
+
+
+def changed_inputs(record):
+  changed = []
+  for path, key in record.get('inputs', {}).items():
+    try:
+      if file_key(os.path.join(record['cwd'], path)) != key:
+        changed.append(path)
+    except OSError:
+      changed.append(path)
+  return changed
+
+
+def launcher_for(record, bin_directory):
+  base = os.path.splitext(os.path.basename(record['script']))[0]
+  directory = bin_directory or os.path.dirname(record['script'])
+  suffix = '.exe' if sys.platform == 'win32' else ''
+  return os.path.join(directory, base + suffix)
+
+
+def environment_for(record, mode, cache_directory):
+  env = {k: v for k, v in os.environ.items()
+         if not k.startswith('EM') or k.startswith('EM_LAUNCHER_')}
+  env.update(record.get('env', {}))
+  if mode != 'recorded':
+    for name in LAUNCHER_VARIABLES:
+      env.pop(name, None)
+    # Explicitly off, or a calibrated launcher may pick the server.
+    env['EM_LAUNCHER_SERVER'] = '1' if mode == 'server' else '0'
+  if mode == 'cache':
+    env['EM_LAUNCHER_CACHE'] = cache_directory
+  return env
+
+
+def run(record, launcher, env):
+  start = time.perf_counter()
+  result = subprocess.run([launcher] + record['args'], cwd=record['cwd'],
+                          env=env, stdin=subprocess.DEVNULL,
+                          stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+  return time.perf_counter() - start, result.returncode
+
+
+def percentile(sorted_values, fraction):
+  if not sorted_values:
+    return 0
+  index = min(len(sorted_values) - 1, int(fraction * len(sorted_values)))
+  return sorted_values[index]
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('corpus', help='the EM_LAUNCHER_RECORD directory')
+  parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(),
+                      help='invocations to run at once')
+  parser.add_argument('--mode', choices=MODES, default='recorded',
+                      help='launcher configuration to replay against')
+  parser.add_argument('--cache-directory',
+                      help='compile cache for --mode cache (a new one by '
+                           'default)')
+  parser.add_argument('--bin', help='directory of the launchers to run')
+  parser.add_argument('--repeat', type=int, default=1,
+                      help='times to replay the corpus')
+  parser.add_argument('--check-inputs', action='store_true',
+                      help='skip records whose input files changed')
+  parser.add_argument('--json', metavar='FILE',
+                      help='also write the results as JSON')
+  args = parser.parse_args()
+  records = load_corpus(args.corpus)
+  if not records:
+    parser.error(f'no records in {args.corpus}')
+  changed = [r for r in records if changed_inputs(r)]
+  if changed:
+    print(f'{len(changed)} of {len(records)} records have changed inputs')
+    if args.check_inputs:
+      records = [r for r in records if r not in changed]
+  cache_directory = args.cache_directory
+  if args.mode == 'cache' and not cache_directory:
+    cache_directory = tempfile.mkdtemp(prefix='launcher-replay-cache-')
+
+  latencies = []
+  failures = 0
+  start = time.perf_counter()
+  with concurrent.futures.ThreadPoolExecutor(args.jobs) as executor:
+    for _ in range(args.repeat):
+      futures = [(record, executor.submit(
+                     run, record, launcher_for(record, args.bin),
+                     environment_for(record, args.mode, cache_directory)))
+                 for record in records]
+      for record, future in futures:
+        elapsed, returncode = future.result()
+        latencies.append(elapsed)
+        failures += returncode != record['exit_code']
+  wall = time.perf_counter() - start
+
+  latencies.sort()
+  results = {
+    'mode': args.mode,
+    'jobs': args.jobs,
+    'invocations': len(latencies),
+    'failures': failures,
+    'wall_s': wall,
+    'throughput_per_s': len(latencies) / wall if wall else 0,
+    'latency_s': {
+      'mean': sum(latencies) / len(latencies),
+      'p50': percentile(latencies, 0.5),
+      'p90': percentile(latencies, 0.9),
+      'p99': percentile(latencies, 0.99),
+      'max': latencies[-1],
+    },
+    'recorded_s': sum(r['duration_ms'] for r in records) / 1000 * args.repeat,
+  }
+  print(f'{results["invocations"]} invocations in {wall:.2f} s '
+        f'({results["throughput_per_s"]:.1f}/s) with {args.jobs} jobs, '
+        f'mode {args.mode}')
+  print('latency: ' + ', '.join(f'{name} {value * 1000:.0f} ms'
+                                for name, value in
+                                results['latency_s'].items()))
+  print(f'recorded time {results["recorded_s"]:.2f} s, '
+        f'{failures} exit codes differ from the recording')
+  if args.json:
+    with open(args.json, 'w') as f:
+      json.dump(results, f, indent=2)
+  return 1 if failures else 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
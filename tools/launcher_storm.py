@@ -0,0 +1,285 @@
+#!/usr/bin/env python3
+# Copyright 2025 The Emscripten Authors.  All rights reserved.
+# Emscripten is available under two separate licenses, the MIT license and the
+# University of Illinois/NCSA Open Source License.  Both these licenses can be
+# found in the LICENSE file.
+
+"""Measures how launcher startup scales under many simultaneous launches.
+
+A build starts dozens of launchers at once, which then contend for file
+locks, the page cache, the loader and the python imports; the startup time of
+a single launcher does not show that. This starts N launchers at a time of a
+stub script, for N from 1 to 4x the number of cores, and reports for each N the
+throughput, the latency distribution, the CPU time spent in the kernel and the
+scaling efficiency, the throughput relative to N times that of one launcher
+(capped at the number of cores):
+
+  python tools/launcher_storm.py --launcher C:\\emsdk\\upstream\\emscripten\\emcc.exe
+  python tools/launcher_storm.py --json storm.json
+
+The launcher is copied next to the stub script, whose name it runs, so any
+launcher works: the one of wrapper.c, or run_python.sh elsewhere. Without
+--launcher the python running this is started directly, which gives the
+baseline of the interpreter alone on any host. --import makes the stub import
+modules, to include their loading in the measurement.
+
+With --server the stub runs on the resident compile server's pool of worker
+processes, and after each level the working set of the pool, as
+`--launcher-status` reports it, is added to the results; with and without
+--server this compares the throughput and memory of the pool with those of
+plain launches.
+"""
+
+import argparse
+import concurrent.futures
+import ctypes
+import datetime
+import json
+import os
+import platform
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+try:
+  import resource
+except ImportError:
+  resource = None
+
+STUB_NAME = 'launcher_storm_stub'
+
+
+def default_levels(cores):
+  levels = []
+  level = 1
+  while level < 4 * cores:
+    levels.append(level)
+    level *= 2
+  levels.append(4 * cores)
+  return levels
+
+
+def system_cpu_times():
+  """(busy, kernel, total) seconds of CPU time of the machine, or None."""
+  if sys.platform == 'win32':
+    idle, kernel, user = (ctypes.c_ulonglong() for _ in range(3))
+    if not ctypes.windll.kernel32.GetSystemTimes(
+        ctypes.byref(idle), ctypes.byref(kernel), ctypes.byref(user)):
+      return None
+    # Kernel time includes the idle time. FILETIME ticks are 100 ns.
+    total = (kernel.value + user.value) / 1e7
+    return (total - idle.value / 1e7,
+            (kernel.value - idle.value) / 1e7, total)
+  try:
+    with open('/proc/stat') as f:
+      fields = [int(value) for value in f.readline().split()[1:]]
+  except (OSError, ValueError):
+    return None
+  ticks = os.sysconf('SC_CLK_TCK')
+  # user nice system idle iowait irq softirq steal...
+  idle = fields[3] + fields[4]
+  kernel = fields[2] + fields[5] + fields[6]
+  total = sum(fields[:8])
+  return (total - idle) / ticks, kernel / ticks, total / ticks
+
+
+def children_cpu_times():
+  """(user, system) seconds of CPU time of the finished children, or None."""
+  if not resource:
+    return None
+  usage = resource.getrusage(resource.RUSAGE_CHILDREN)
+  return usage.ru_utime, usage.ru_stime
+
+
+def prepare(directory, launcher, imports):
+  """The command that runs the stub script in |directory|."""
+  script = os.path.join(directory, STUB_NAME + '.py')
+  with open(script, 'w') as f:
+    for module in imports:
+      f.write(f'import {module}\n')
+    f.write('import sys\nsys.exit(0)\n')
+  if not launcher:
+    return [sys.executable, '-E', script]
+  extension = os.path.splitext(launcher)[1]
+  copy = os.path.join(directory, STUB_NAME + extension)
+  shutil.copy2(launcher, copy)
+  return [copy]
+
+
+def storm(command, env, level, launches):
+  """Runs |launches| launches, |level| at a time; returns the measurement."""
+  latencies = []
+  failures = []
+  lock = threading.Lock()
+  remaining = [launches]
+
+  def worker():
+    while True:
+      with lock:
+        if not remaining[0]:
+          return
+        remaining[0] -= 1
+      start = time.perf_counter()
+      returncode = subprocess.call(command, env=env,
+                                   stdin=subprocess.DEVNULL,
+                                   stdout=subprocess.DEVNULL,
+                                   stderr=subprocess.DEVNULL)
+      elapsed = time.perf_counter() - start
+      with lock:
+        latencies.append(elapsed)
+        if returncode:
+          failures.append(returncode)
+
+  system_before = system_cpu_times()
+  children_before = children_cpu_times()
+  start = time.perf_counter()
+  with concurrent.futures.ThreadPoolExecutor(level) as executor:
+    for future in [executor.submit(worker) for _ in range(level)]:
+      future.result()
+  wall = time.perf_counter() - start
+  system_after = system_cpu_times()
+  children_after = children_cpu_times()
+
+  latencies.sort()
+  result = {
+    'level': level,
+    'launches': launches,
+    'failures': len(failures),
+    'wall_s': wall,
+    'throughput_per_s': launches / wall,
+    'latency_ms': {
+      'mean': sum(latencies) / len(latencies) * 1000,
+      'p50': percentile(latencies, 0.5) * 1000,
+      'p90': percentile(latencies, 0.9) * 1000,
+      'p99': percentile(latencies, 0.99) * 1000,
+      'max': latencies[-1] * 1000,
+    },
+  }
+  if system_before and system_after:
+    busy, kernel, total = (after - before for before, after in
+                           zip(system_before, system_after))
+    result['machine_busy'] = busy / total if total else 0
+    result['machine_kernel'] = kernel / total if total else 0
+  if children_before and children_after:
+    user, system = (after - before for before, after in
+                    zip(children_before, children_after))
+    result['user_ms_per_launch'] = user / launches * 1000
+    result['system_ms_per_launch'] = system / launches * 1000
+  return result
+
+
+def server_resident_bytes(command, env):
+  """The summed working set of the server's workers, or None."""
+  result = subprocess.run(command + ['--launcher-status'], env=env,
+                          stdin=subprocess.DEVNULL, stdout=subprocess.PIPE,
+                          stderr=subprocess.DEVNULL, universal_newlines=True)
+  if result.returncode:
+    return None
+  values = re.findall(r'^emscripten_launcher_server_worker_resident_bytes'
+                      r'\{[^}]*\} (\d+)$', result.stdout, re.MULTILINE)
+  return sum(int(value) for value in values) if values else None
+
+
+def percentile(sorted_values, fraction):
+  index = min(len(sorted_values) - 1, int(fraction * len(sorted_values)))
+  return sorted_values[index]
+
+
+def print_result(result):
+  latency = result['latency_ms']
+  line = (f'{result["level"]:5} {result["throughput_per_s"]:9.1f}/s '
+          f'{result["efficiency"]:6.1%} {latency["p50"]:8.1f} '
+          f'{latency["p90"]:8.1f} {latency["p99"]:8.1f} {latency["max"]:8.1f}')
+  if 'machine_kernel' in result:
+    line += f' {result["machine_busy"]:6.1%} {result["machine_kernel"]:6.1%}'
+  if 'system_ms_per_launch' in result:
+    line += (f' {result["user_ms_per_launch"]:8.1f} '
+             f'{result["system_ms_per_launch"]:8.1f}')
+  if 'server_resident_mb' in result:
+    line += f' {result["server_resident_mb"]:8.1f}'
+  if result['failures']:
+    line += f'  {result["failures"]} failed'
+  print(line)
+
+
+def main():
+  cores = os.cpu_count() or 1
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('--launcher',
+                      help='launcher to measure (python itself by default)')
+  parser.add_argument('--levels',
+                      help='comma separated numbers of simultaneous launches '
+                           '(powers of two up to 4x the cores by default)')
+  parser.add_argument('--launches', type=int, default=8,
+                      help='launches per simultaneous launch at each level')
+  parser.add_argument('--import', dest='imports', action='append',
+                      default=[], metavar='MODULE',
+                      help='module for the stub script to import')
+  parser.add_argument('--server', action='store_true',
+                      help='run the stub on the resident compile server')
+  parser.add_argument('--json', metavar='FILE',
+                      help='also write the results as JSON')
+  args = parser.parse_args()
+  levels = ([int(level) for level in args.levels.split(',')] if args.levels
+            else default_levels(cores))
+  # Efficiency is relative to a single launcher.
+  if levels[0] != 1:
+    levels.insert(0, 1)
+  env = dict(os.environ)
+  for name in ('EM_LAUNCHER_CACHE', 'EM_LAUNCHER_SERVER',
+               'EM_LAUNCHER_TELEMETRY', 'EM_LAUNCHER_PROFILE',
+               'EM_LAUNCHER_RECORD'):
+    env.pop(name, None)
+  # Explicitly off, or a calibrated launcher may pick the server.
+  env['EM_LAUNCHER_SERVER'] = '1' if args.server else '0'
+
+  directory = tempfile.mkdtemp(prefix='launcher-storm-')
+  try:
+    command = prepare(directory, args.launcher, args.imports)
+    # Warm the page cache, and start the server when there is one.
+    storm(command, env, 1, 2)
+    print(f'{cores} cores, {platform.system()} {platform.release()}, '
+          f'python {platform.python_version()}')
+    print('level throughput effic.  p50 ms   p90 ms   p99 ms   max ms'
+          '  busy kernel  user ms  sys ms' +
+          ('  pool MB' if args.server and args.launcher else ''))
+    results = []
+    for level in levels:
+      result = storm(command, env, level, level * args.launches)
+      single = (results[0] if results else result)['throughput_per_s']
+      result['efficiency'] = (result['throughput_per_s'] /
+                              (single * min(level, cores)))
+      if args.server and args.launcher:
+        resident = server_resident_bytes(command, env)
+        if resident is not None:
+          result['server_resident_mb'] = resident / (1 << 20)
+      results.append(result)
+      print_result(result)
+  finally:
+    shutil.rmtree(directory, ignore_errors=True)
+
+  if args.json:
+    with open(args.json, 'w') as f:
+      json.dump({
+        'time': datetime.datetime.now(datetime.timezone.utc).isoformat(),
+        'host': {
+          'cores': cores,
+          'system': platform.system(),
+          'release': platform.release(),
+          'machine': platform.machine(),
+          'python': platform.python_version(),
+        },
+        'launcher': args.launcher or sys.executable,
+        'imports': args.imports,
+        'server': args.server,
+        'results': results,
+      }, f, indent=2)
+  return 1 if any(r['failures'] for r in results) else 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,314 @@
+#!/usr/bin/env python3
+# Copyright 2025 The Emscripten Authors.  All rights reserved.
+# Emscripten is available under two separate licenses, the MIT license and the
+# University of Illinois/NCSA Open Source License.  Both these licenses can be
+# found in the LICENSE file.
+
+"""Finds where a build's critical path spends its time in the launcher.
+
+Joins a launcher telemetry log (see telemetry.c.inc) with the .ninja_log of
+the same build, by the output file of each job:
+
+  launcher --launcher-telemetry-collect build C:\\build\\telemetry.log
+  set EM_LAUNCHER_TELEMETRY=build
+  ninja -C C:\\build
+  launcher --launcher-telemetry-stop build
+  python tools/launcher_trace.py C:\\build\\telemetry.log C:\\build\\.ninja_log \\
+      --chrome-trace trace.json
+
+The .ninja_log has no dependencies, so the critical path is estimated from the
+timeline: walking back from the job that finished last, the predecessor of a
+job is the one that finished last before it started. The time python spent
+waiting for its child tools (clang, wasm-ld, node) is estimated as the time in
+the script beyond the CPU time of the launcher process.
+
+For each launcher mode seen in the log the report estimates the critical path
+if every launcher job on it had taken the mean time that mode took for jobs of
+the same script. The trace opens in chrome://tracing or Perfetto.
+"""
+
+import argparse
+import collections
+import json
+import os
+import struct
+
+LOG_HEADER = struct.Struct('<4I')
+RECORD = struct.Struct('<qq6I4I5Q32s')
+MAGIC = 0x544c4d45
+VERSION = 1
+PHASES = ['launcher load', 'setup', 'cache', 'server', 'python load', 'script']
+MODES = ['python', 'cache', 'server', 'native']
+FNV_OFFSET_BASIS = 0xcbf29ce484222325
+FNV_PRIME = 0x100000001b3
+# FILETIME ticks per microsecond.
+TICKS_PER_US = 10
+
+
+def fnv1a(text):
+  """The hash telemetry.c.inc takes of a UTF-16 string and its terminator."""
+  value = FNV_OFFSET_BASIS
+  for byte in (text + '\0').encode('utf-16-le'):
+    value = ((value ^ byte) * FNV_PRIME) & 0xffffffffffffffff
+  return value
+
+
+class Record:
+  def __init__(self, fields):
+    (_, start_time, *rest) = fields
+    self.phase_us = rest[0:6]
+    (self.process_id, self.exit_code, mode, self.page_faults,
+     self.user_us, self.kernel_us, self.peak_working_set,
+     self.arguments_hash, self.output_hash, script) = rest[6:]
+    self.start_us = start_time // TICKS_PER_US
+    self.mode = MODES[mode] if mode < len(MODES) else str(mode)
+    self.script = script.decode('utf-16-le').split('\0')[0]
+    self.total_us = sum(self.phase_us)
+    # Set on a cache miss, whose compile ran in a child launcher.
+    self.child = None
+
+  def breakdown(self):
+    """Microseconds by phase, with the script split as the doc says."""
+    parts = dict(zip(PHASES, self.phase_us))
+    script = parts.pop('script')
+    # The child of a cache miss did the work of the cache phase.
+    source = self.child or self
+    if source is not self:
+      parts['cache'] = max(0, parts['cache'] - source.total_us)
+      for name, value in source.breakdown().items():
+        parts[name] = parts.get(name, 0) + value
+      return parts
+    cpu = min(script, self.user_us + self.kernel_us)
+    parts['python (on CPU)'] = cpu
+    parts['child tools (estimated)'] = script - cpu
+    return parts
+
+
+def load_records(path):
+  with open(path, 'rb') as f:
+    data = f.read()
+  if len(data) < LOG_HEADER.size:
+    raise ValueError(f'{path}: not a telemetry log')
+  magic, version, record_size, _ = LOG_HEADER.unpack_from(data)
+  if magic != MAGIC or version != VERSION or record_size != RECORD.size:
+    raise ValueError(f'{path}: not a telemetry log of version {VERSION}')
+  body = data[LOG_HEADER.size:]
+  # A collector killed mid-write leaves a partial record.
+  body = body[:len(body) - len(body) % RECORD.size]
+  records = [Record(fields) for fields in RECORD.iter_unpack(body)]
+  records.sort(key=lambda r: r.start_us)
+  return records
+
+
+def by_output(records):
+  """The last top-level record of each output; children hang off parents."""
+  latest = {}
+  for record in records:
+    if not record.output_hash:
+      continue
+    parent = latest.get(record.output_hash)
+    if (parent and parent.mode == 'cache' and parent.child is None and
+        record.start_us < parent.start_us + parent.total_us):
+      parent.child = record
+      continue
+    latest[record.output_hash] = record
+  return latest
+
+
+class Job:
+  def __init__(self, start_ms, end_ms, outputs):
+    self.start_us = start_ms * 1000
+    self.end_us = end_ms * 1000
+    self.outputs = outputs
+    self.record = None
+    self.critical = False
+
+  @property
+  def duration_us(self):
+    return self.end_us - self.start_us
+
+
+def load_ninja_jobs(path):
+  """The jobs of the last build in a .ninja_log, outputs grouped by command."""
+  with open(path) as f:
+    header = f.readline()
+    if not header.startswith('# ninja log v'):
+      raise ValueError(f'{path}: not a .ninja_log')
+    entries = []
+    last_end = -1
+    for line in f:
+      fields = line.rstrip('\n').split('\t')
+      if len(fields) < 5:
+        continue
+      start, end = int(fields[0]), int(fields[1])
+      # A new build restarts the clock.
+      if end < last_end:
+        entries = []
+      last_end = end
+      entries.append((start, end, fields[4], fields[3]))
+  grouped = collections.OrderedDict()
+  for start, end, command_hash, output in entries:
+    grouped.setdefault((start, end, command_hash), []).append(output)
+  return [Job(start, end, outputs)
+          for (start, end, _), outputs in grouped.items()]
+
+
+def join(jobs, records, build_directory):
+  latest = by_output(records)
+  for job in jobs:
+    for output in job.outputs:
+      candidates = {output, output.replace('/', '\\'),
+                    os.path.normpath(os.path.join(build_directory, output))}
+      for candidate in candidates:
+        record = latest.get(fnv1a(candidate))
+        if record:
+          job.record = record
+          break
+      if job.record:
+        break
+
+
+def critical_path(jobs):
+  if not jobs:
+    return []
+  ordered = sorted(jobs, key=lambda j: j.end_us)
+  path = [ordered[-1]]
+  while True:
+    current = path[-1]
+    before = [j for j in ordered if j.end_us <= current.start_us]
+    if not before:
+      break
+    path.append(before[-1])
+  path.reverse()
+  for job in path:
+    job.critical = True
+  return path
+
+
+def breakdown(jobs):
+  totals = collections.Counter()
+  for job in jobs:
+    if job.record:
+      parts = job.record.breakdown()
+      totals.update(parts)
+      # Ninja's view of the job includes what the launcher does not see.
+      totals['outside the launcher'] += max(
+          0, job.duration_us - sum(parts.values()))
+    else:
+      totals['not a launcher job'] += job.duration_us
+  return totals
+
+
+def mode_means(records):
+  """Mean microseconds by (mode, script) of top-level records."""
+  sums = collections.defaultdict(lambda: [0, 0])
+  children = {id(r.child) for r in records if r.child}
+  for record in records:
+    if id(record) in children:
+      continue
+    entry = sums[(record.mode, record.script)]
+    entry[0] += record.total_us
+    entry[1] += 1
+  return {key: total / count for key, (total, count) in sums.items()}
+
+
+def estimate(path, means, mode):
+  """The critical path length if its launcher jobs used |mode|, or None."""
+  total = 0
+  found = False
+  for job in path:
+    duration = job.duration_us
+    if job.record:
+      mean = means.get((mode, job.record.script))
+      if mean is not None:
+        found = True
+        duration += mean - job.record.total_us
+    total += max(0, duration)
+  return total if found else None
+
+
+def seconds(us):
+  return f'{us / 1e6:9.2f} s'
+
+
+def print_report(jobs, path, records):
+  wall = (max(j.end_us for j in jobs) - min(j.start_us for j in jobs)
+          if jobs else 0)
+  path_us = sum(j.duration_us for j in path)
+  launcher_jobs = [j for j in jobs if j.record]
+  print(f'jobs:          {len(jobs)} ({len(launcher_jobs)} joined with '
+        f'launcher records)')
+  print(f'wall time:     {seconds(wall)}')
+  print(f'critical path: {seconds(path_us)} over {len(path)} jobs '
+        f'({sum(1 for j in path if j.record)} launcher jobs)')
+  for title, selected in (('critical path', path), ('all jobs', jobs)):
+    totals = breakdown(selected)
+    overall = sum(totals.values()) or 1
+    print()
+    print(f'{title} time by phase:')
+    for name, value in totals.most_common():
+      print(f'  {name:26} {seconds(value)} {value / overall:7.1%}')
+  means = mode_means(records)
+  print()
+  print('estimated critical path by launcher mode:')
+  for mode in MODES:
+    estimated = estimate(path, means, mode)
+    if estimated is None:
+      print(f'  {mode:26}   no records')
+    else:
+      speedup = path_us / estimated if estimated else float('inf')
+      print(f'  {mode:26} {seconds(estimated)} {speedup:6.2f}x')
+
+
+def write_chrome_trace(path, jobs):
+  # Lanes so that overlapping jobs do not share a row.
+  lane_ends = []
+  events = []
+  for job in sorted(jobs, key=lambda j: j.start_us):
+    for lane, end in enumerate(lane_ends):
+      if end <= job.start_us:
+        break
+    else:
+      lane = len(lane_ends)
+      lane_ends.append(0)
+    lane_ends[lane] = job.end_us
+    args = {'outputs': job.outputs}
+    if job.record:
+      args.update(mode=job.record.mode, exit_code=job.record.exit_code,
+                  pid=job.record.process_id,
+                  peak_working_set=job.record.peak_working_set)
+    events.append({'name': os.path.basename(job.outputs[0]),
+                   'cat': 'critical' if job.critical else 'job',
+                   'ph': 'X', 'pid': 0, 'tid': lane, 'ts': job.start_us,
+                   'dur': job.duration_us, 'args': args})
+    if job.record:
+      # Phases run one after the other from the start of the job.
+      start = job.start_us
+      for name, value in job.record.breakdown().items():
+        if value:
+          events.append({'name': name, 'cat': 'phase', 'ph': 'X', 'pid': 0,
+                         'tid': lane, 'ts': start, 'dur': value})
+          start += value
+  with open(path, 'w') as f:
+    json.dump({'traceEvents': events, 'displayTimeUnit': 'ms'}, f)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('telemetry_log',
+                      help='log written by --launcher-telemetry-collect')
+  parser.add_argument('ninja_log', help='the .ninja_log of the build')
+  parser.add_argument('--chrome-trace', metavar='FILE',
+                      help='also write the build as a Chrome trace')
+  args = parser.parse_args()
+  records = load_records(args.telemetry_log)
+  jobs = load_ninja_jobs(args.ninja_log)
+  join(jobs, records, os.path.dirname(os.path.abspath(args.ninja_log)))
+  path = critical_path(jobs)
+  print_report(jobs, path, records)
+  if args.chrome_trace:
+    write_chrome_trace(args.chrome_trace, jobs)
+
+
+if __name__ == '__main__':
+  main()
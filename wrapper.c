@@ -8,7 +8,55 @@
  * On non-windows platforms this is done via the run_pyton.sh shell script.
  *
  * The binary will look for a python script that matches its own name and run
- * that using python3.dll.
+ * that using python3.dll. One binary serves every tool, hard linked under
+ * each tool's name.
+ *
+ * A first argument of the form --launcher-<command> is answered by the launcher
+ * itself without loading python:
+ *   --launcher-copy <source> <destination>
+ *       Copy a file using the cheapest mechanism the volume supports (see
+ *       file_copy.c.inc). Available to emcc for its own cache copies.
+ *   --launcher-cache-stats
+ *       Print compile cache statistics (see cache_maintenance.c.inc).
+ *   --launcher-cache-benchmark <file>...
+ *       Measure cache compression and restore speed on the given files.
+ *   --launcher-cache-index-benchmark <writers> <operations> [<index>]
+ *       Measure the throughput of the cache index under concurrent writers,
+ *       on a private index or on one shared by several processes.
+ *   --launcher-cache-compact <dir>
+ *       Evict entries until the cache is under its size limit; started
+ *       detached by the launcher.
+ *   --launcher-cache-upload <dir> <key>
+ *       Upload a stored entry to EM_LAUNCHER_CACHE_REMOTE; started detached
+ *       by the launcher.
+ *
+ *   --launcher-server
+ *       Run the resident compile server (see server.c.inc).
+ *   --launcher-status
+ *       Print the metrics of the resident compile server.
+ *   --launcher-calibrate [--when-idle]
+ *       Measure which launcher mode is fastest on this host and make it the
+ *       default, with --when-idle once the machine is idle (see
+ *       calibrate.c.inc).
+ *   --launcher-link-tools [tool name]...
+ *       Replace the copies of the launcher next to it by hard links, so that
+ *       all the tools share one binary (see multicall.c.inc).
+ *   --launcher-telemetry-collect <name> <log file>
+ *       Collect the telemetry of launchers (see telemetry.c.inc).
+ *   --launcher-telemetry-stop <name>
+ *       Make the collector of <name> drain its ring and exit.
+ *   --launcher-telemetry-benchmark <writers> <records>
+ *       Measure the throughput of the telemetry ring under concurrent writers.
+ *
+ * Setting EM_LAUNCHER_CACHE to a directory enables the compile cache (see
+ * cache.c.inc). Setting EM_LAUNCHER_SERVER to 1 runs scripts on the resident
+ * compile server, which starts on first use (see server_client.c.inc).
+ * Setting EM_LAUNCHER_TELEMETRY to the name of a collector records the phase
+ * timings of every invocation (see telemetry.c.inc). Setting
+ * EM_LAUNCHER_PROFILE to a directory profiles the scripts (see profile.c.inc),
+ * and EM_LAUNCHER_RECORD to a directory records every invocation for replay
+ * (see record.c.inc). Started as emar or emranlib, the launcher runs llvm-ar
+ * or llvm-ranlib itself once it knows where they are (see native_tools.c.inc).
  */
 
 // Define _WIN32_WINNT to Windows 7 for max portability
@@ -21,13 +69,16 @@
 #include <windows.h>
 
 #include <minwindef.h>
+#include <psapi.h>
 #include <wchar.h>
+#include <winioctl.h>
 
 typedef int (*Py_MainFunction)(int argc, wchar_t** argv);
 
 #define malloc malloc_local
 #define realloc realloc_local
 #define memcpy memcpy_local
+#define memset memset_local
 #define free free_local
 
 static void* malloc(size_t _Size) {
@@ -53,6 +104,177 @@ static void* memcpy(void* _Dst, void const* _Src, size_t _Size) {
   return dst;
 }
 
+static void* memset(void* _Dst, int _Val, size_t _Size) {
+  uint8_t* dst = (uint8_t*)_Dst;
+  for (size_t i = 0; i < _Size; ++i) {
+    dst[i] = (uint8_t)_Val;
+  }
+  return dst;
+}
+
+// Returns a newly allocated string holding |a| followed by |b|.
+static wchar_t* string_concat(const wchar_t* a, const wchar_t* b) {
+  int a_length = lstrlenW(a);
+  int b_length = lstrlenW(b);
+  wchar_t* result = malloc((a_length + b_length + 1) * sizeof(wchar_t));
+  if (result) {
+    memcpy(result, a, a_length * sizeof(wchar_t));
+    memcpy(result + a_length, b, (b_length + 1) * sizeof(wchar_t));
+  }
+  return result;
+}
+
+// Returns a newly allocated path made of |directory| and |name|.
+static wchar_t* path_join(const wchar_t* directory, const wchar_t* name) {
+  int length = lstrlenW(directory);
+  if (length > 0 && directory[length - 1] != L'\\' &&
+      directory[length - 1] != L'/') {
+    wchar_t* with_separator = string_concat(directory, L"\\");
+    if (!with_separator)
+      return NULL;
+    wchar_t* result = string_concat(with_separator, name);
+    free(with_separator);
+    return result;
+  }
+  return string_concat(directory, name);
+}
+
+// Returns the file name part of |path|.
+static const wchar_t* path_basename(const wchar_t* path) {
+  const wchar_t* basename = path;
+  for (const wchar_t* p = path; *p; ++p) {
+    if (*p == L'\\' || *p == L'/' || *p == L':')
+      basename = p + 1;
+  }
+  return basename;
+}
+
+static bool string_starts_with(const wchar_t* string, const wchar_t* prefix) {
+  for (; *prefix; ++string, ++prefix) {
+    if (*string != *prefix)
+      return false;
+  }
+  return true;
+}
+
+// Writes |text| to |handle|, which may be a console, a pipe or a file.
+static void write_text(HANDLE handle, const wchar_t* text) {
+  int length = lstrlenW(text);
+  DWORD mode;
+  DWORD written;
+  if (GetConsoleMode(handle, &mode)) {
+    WriteConsoleW(handle, text, length, &written, NULL);
+    return;
+  }
+  int size = WideCharToMultiByte(CP_UTF8, 0, text, length, NULL, 0, NULL, NULL);
+  char* buffer = malloc(size > 0 ? size : 1);
+  if (buffer) {
+    WideCharToMultiByte(CP_UTF8, 0, text, length, buffer, size, NULL, NULL);
+    WriteFile(handle, buffer, size, &written, NULL);
+    free(buffer);
+  }
+}
+
+// A growable byte array, also used to build wide strings.
+typedef struct byte_buffer {
+  uint8_t* data;
+  size_t size;
+  size_t capacity;
+} byte_buffer;
+
+static bool byte_buffer_reserve(byte_buffer* buffer, size_t size) {
+  if (buffer->capacity - buffer->size >= size)
+    return true;
+  size_t capacity = buffer->capacity * 2 + 256;
+  if (capacity - buffer->size < size)
+    capacity = buffer->size + size;
+  uint8_t* data = realloc(buffer->data, capacity);
+  if (!data)
+    return false;
+  buffer->data = data;
+  buffer->capacity = capacity;
+  return true;
+}
+
+static bool byte_buffer_append(byte_buffer* buffer,
+                               const void* data,
+                               size_t size) {
+  if (!byte_buffer_reserve(buffer, size))
+    return false;
+  memcpy(buffer->data + buffer->size, data, size);
+  buffer->size += size;
+  return true;
+}
+
+// Appends |string| without its terminating null character.
+static bool byte_buffer_append_string(byte_buffer* buffer,
+                                      const wchar_t* string) {
+  return byte_buffer_append(buffer, string, lstrlenW(string) * sizeof(wchar_t));
+}
+
+static void byte_buffer_free(byte_buffer* buffer) {
+  if (buffer->data)
+    free(buffer->data);
+  buffer->data = NULL;
+  buffer->size = 0;
+  buffer->capacity = 0;
+}
+
+static bool byte_buffer_append_decimal(byte_buffer* buffer, uint64_t value) {
+  wchar_t digits[20];
+  int count = 0;
+  do {
+    digits[count++] = (wchar_t)(L'0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+  bool ok = true;
+  while (ok && count > 0) {
+    ok = byte_buffer_append(buffer, &digits[--count], sizeof(wchar_t));
+  }
+  return ok;
+}
+
+// Appends |tenths| / 10 with one decimal, e.g. 123 as "12.3".
+static bool byte_buffer_append_tenths(byte_buffer* buffer, uint64_t tenths) {
+  wchar_t fraction[] = L".0";
+  fraction[1] = (wchar_t)(L'0' + tenths % 10);
+  return byte_buffer_append_decimal(buffer, tenths / 10) &&
+         byte_buffer_append_string(buffer, fraction);
+}
+
+// Appends a byte count in the largest binary unit that keeps it above one.
+static bool byte_buffer_append_size(byte_buffer* buffer, uint64_t bytes) {
+  static const wchar_t* const units[] = {L" KiB", L" MiB", L" GiB", L" TiB"};
+  if (bytes < 1024) {
+    return byte_buffer_append_decimal(buffer, bytes) &&
+           byte_buffer_append_string(buffer, L" B");
+  }
+  int unit = 0;
+  uint64_t divisor = 1024;
+  while (unit < 3 && bytes / divisor >= 1024) {
+    divisor *= 1024;
+    ++unit;
+  }
+  return byte_buffer_append_tenths(buffer, bytes * 10 / divisor) &&
+         byte_buffer_append_string(buffer, units[unit]);
+}
+
+// Writes the wide text accumulated in |buffer| to |handle|.
+static void write_text_buffer(HANDLE handle, byte_buffer* buffer) {
+  static const wchar_t terminator = 0;
+  if (byte_buffer_append(buffer, &terminator, sizeof(terminator))) {
+    write_text(handle, (const wchar_t*)buffer->data);
+    buffer->size -= sizeof(terminator);
+  }
+}
+
+#include "file_copy.c.inc"
+#include "hash.c.inc"
+#include "lz4.c.inc"
+#include "http.c.inc"
+#include "process.c.inc"
+#include "shared_table.c.inc"
+
 typedef DWORD (*windows_api_get_buffer_callback)(const void* context,
                                                  wchar_t* buffer,
                                                  DWORD buffer_size);
@@ -333,7 +555,138 @@ wchar_t** emcc_get_argc_argv(int* argc_ptr) {
   return argv;
 }
 
+#include "base_directory.c.inc"
+#include "cache.c.inc"
+#include "cache_maintenance.c.inc"
+#include "server.c.inc"
+#include "server_client.c.inc"
+#include "telemetry.c.inc"
+#include "profile.c.inc"
+#include "record.c.inc"
+#include "calibrate.c.inc"
+#include "multicall.c.inc"
+#include "native_tools.c.inc"
+
+// Reports the end of this invocation to the telemetry collector and the
+// replay corpus. |argv| is [program, -E, script, user arguments...].
+static void finish_invocation(int argc,
+                              wchar_t** argv,
+                              telemetry_mode mode,
+                              int ret) {
+  telemetry_finish(argv[2], argc - 3, argv + 3, mode, ret);
+  record_finish(argv[2], argc - 3, argv + 3, mode, ret);
+}
+
+// Handles the --launcher-* commands that are answered by the launcher itself,
+// without loading python. |argc| and |argv| are the user arguments only.
+// Returns false when the arguments are meant for the script.
+static bool run_launcher_command(int argc, wchar_t** argv, int* ret_ptr) {
+  if (argc < 1 || !string_starts_with(argv[0], L"--launcher-"))
+    return false;
+  HANDLE stderr_handle = GetStdHandle(STD_ERROR_HANDLE);
+  *ret_ptr = 1;
+  if (lstrcmpW(argv[0], L"--launcher-copy") == 0) {
+    // Exposes the launcher's file materialization, which emcc may use for its
+    // own cache copies: --launcher-copy <source> <destination>
+    if (argc != 3) {
+      write_text(stderr_handle,
+                 L"usage: --launcher-copy <source> <destination>\n");
+      return true;
+    }
+    if (copy_file_fast(argv[1], argv[2])) {
+      *ret_ptr = 0;
+    } else {
+      write_text(stderr_handle, L"--launcher-copy: copy failed\n");
+    }
+    return true;
+  }
+  if (lstrcmpW(argv[0], L"--launcher-cache-stats") == 0) {
+    *ret_ptr = cache_stats_command();
+    return true;
+  }
+  if (lstrcmpW(argv[0], L"--launcher-cache-benchmark") == 0) {
+    *ret_ptr = cache_benchmark_command(argc - 1, argv + 1);
+    return true;
+  }
+  if (lstrcmpW(argv[0], L"--launcher-cache-index-benchmark") == 0 &&
+      (argc == 3 || argc == 4)) {
+    *ret_ptr = cache_index_benchmark_command((int)parse_decimal(argv[1]),
+                                             parse_decimal(argv[2]),
+                                             argc == 4 ? argv[3] : NULL);
+    return true;
+  }
+  if (lstrcmpW(argv[0], L"--launcher-cache-compact") == 0 && argc == 2) {
+    *ret_ptr = cache_compact_command(argv[1]);
+    return true;
+  }
+  if (lstrcmpW(argv[0], L"--launcher-cache-upload") == 0 && argc == 3) {
+    *ret_ptr = cache_upload_command(argv[1], argv[2]);
+    return true;
+  }
+  if (lstrcmpW(argv[0], L"--launcher-server") == 0) {
+    *ret_ptr = server_command();
+    return true;
+  }
+  if (lstrcmpW(argv[0], L"--launcher-status") == 0) {
+    *ret_ptr = server_status_command();
+    return true;
+  }
+  if (lstrcmpW(argv[0], L"--launcher-calibrate") == 0 &&
+      (argc == 1 ||
+       (argc == 2 && lstrcmpW(argv[1], L"--when-idle") == 0))) {
+    *ret_ptr = calibrate_command(argc == 2);
+    return true;
+  }
+  if (lstrcmpW(argv[0], L"--launcher-link-tools") == 0) {
+    *ret_ptr = link_tools_command(argc - 1, argv + 1);
+    return true;
+  }
+  if (lstrcmpW(argv[0], L"--launcher-telemetry-collect") == 0 && argc == 3) {
+    *ret_ptr = telemetry_collect_command(argv[1], argv[2]);
+    return true;
+  }
+  if (lstrcmpW(argv[0], L"--launcher-telemetry-stop") == 0 && argc == 2) {
+    *ret_ptr = telemetry_stop_command(argv[1]);
+    return true;
+  }
+  if (lstrcmpW(argv[0], L"--launcher-telemetry-benchmark") == 0 && argc == 3) {
+    *ret_ptr = telemetry_benchmark_command(argv[1], argv[2]);
+    return true;
+  }
+  write_text(stderr_handle, L"unknown launcher command: ");
+  write_text(stderr_handle, argv[0]);
+  write_text(stderr_handle, L"\n");
+  return true;
+}
+
 void wmainCRTStartup() {
+  int argc;
+  wchar_t** argv = emcc_get_argc_argv(&argc);
+  int ret = -1;
+  // A worker of the compile server runs the server's worker script instead,
+  // see server.c.inc.
+  bool worker = argv && argc == 6 &&
+                lstrcmpW(argv[3], L"--launcher-worker") == 0;
+  HANDLE worker_memory = NULL;
+  if (worker) {
+    worker_memory = (HANDLE)(uintptr_t)parse_decimal(argv[5]);
+    wchar_t** worker_argv = server_worker_arguments(argv, &argc);
+    if (!worker_argv)
+      ExitProcess(1);
+    // The original buffer holds the strings of the new argv.
+    argv = worker_argv;
+  }
+  // argv is [program, -E, script, user arguments...]
+  if (argv && run_launcher_command(argc - 3, argv + 3, &ret)) {
+    free(argv);
+    ExitProcess(ret);
+  }
+  if (argv && !worker) {
+    telemetry_begin();
+    record_begin();
+    calibrate_apply();
+  }
+
   // -E will not ignore _PYTHON_SYSCONFIGDATA_NAME an internal
   // of cpython used in cross compilation via setup.py.
   SetEnvironmentVariableW(L"_PYTHON_SYSCONFIGDATA_NAME", L"");
@@ -346,6 +699,41 @@ void wmainCRTStartup() {
     CloseHandle(GetStdHandle(STD_INPUT_HANDLE));
   }
 
+  telemetry_end_phase(TELEMETRY_PHASE_SETUP);
+  if (argv && compile_cache_run(argv[2], argc - 3, argv + 3, &ret)) {
+    telemetry_end_phase(TELEMETRY_PHASE_CACHE);
+    finish_invocation(argc, argv, TELEMETRY_MODE_CACHE, ret);
+    free(argv);
+    ExitProcess(ret);
+  }
+  telemetry_end_phase(TELEMETRY_PHASE_CACHE);
+
+  bool profiling = !worker && profile_enabled();
+  if (argv && !worker && !profiling &&
+      native_tool_dispatch(argv[2], argc - 3, argv + 3, &ret)) {
+    telemetry_end_phase(TELEMETRY_PHASE_SCRIPT);
+    finish_invocation(argc, argv, TELEMETRY_MODE_NATIVE, ret);
+    free(argv);
+    ExitProcess(ret);
+  }
+  // A native tool whose path is not known yet learns it from its script,
+  // which therefore runs here rather than on the server.
+  int learn_argc = 0;
+  wchar_t* learn_strings = NULL;
+  wchar_t** learn_argv =
+      argv && !worker && !profiling
+          ? native_tools_learn_arguments(argc, argv, &learn_argc,
+                                         &learn_strings)
+          : NULL;
+  if (argv && !profiling && !learn_argv &&
+      server_client_run(argv[2], argc - 3, argv + 3, &ret)) {
+    telemetry_end_phase(TELEMETRY_PHASE_SERVER);
+    finish_invocation(argc, argv, TELEMETRY_MODE_SERVER, ret);
+    free(argv);
+    ExitProcess(ret);
+  }
+  telemetry_end_phase(TELEMETRY_PHASE_SERVER);
+
   wchar_t* emsdk_python_dll_path =
       get_environment_variable(L"EMSDK_PYTHON_DLL", NULL);
   HMODULE python_hmodule = NULL;
@@ -355,20 +743,40 @@ void wmainCRTStartup() {
   } else {
     python_hmodule = LoadLibraryW(L"python3.dll");
   }
-  int ret = -1;
   if (python_hmodule) {
     Py_MainFunction Py_Main =
         (Py_MainFunction)GetProcAddress(python_hmodule, "Py_Main");
-    if (Py_Main) {
-      int argc;
-      wchar_t** argv = emcc_get_argc_argv(&argc);
-      if (argv) {
-        ret = Py_Main(argc, argv);
-        free(argv);
-      }
+    telemetry_end_phase(TELEMETRY_PHASE_PYTHON_LOAD);
+    int profile_argc = 0;
+    wchar_t* profile_output = NULL;
+    wchar_t** profile_argv =
+        profiling && argv ? profile_arguments(argc, argv, &profile_argc,
+                                              &profile_output)
+                          : NULL;
+    if (Py_Main && profile_argv) {
+      ret = Py_Main(profile_argc, profile_argv);
+    } else if (Py_Main && learn_argv) {
+      ret = Py_Main(learn_argc, learn_argv);
+    } else if (Py_Main && argv) {
+      ret = Py_Main(argc, argv);
+    }
+    if (profile_argv) {
+      free(profile_argv);
+      free(profile_output);
     }
+    telemetry_end_phase(TELEMETRY_PHASE_SCRIPT);
+    if (worker_memory)
+      server_worker_report_memory(worker_memory);
     FreeLibrary(python_hmodule);
   }
+  if (learn_argv) {
+    free(learn_argv);
+    free(learn_strings);
+  }
+  if (argv) {
+    finish_invocation(argc, argv, TELEMETRY_MODE_PYTHON, ret);
+    free(argv);
+  }
 
   ExitProcess(ret);
 }